@@ -0,0 +1,200 @@
+//
+//  BookSide.hpp
+//  simple_cross
+//
+//  Book side policies for `BasicSimpleCross`.
+//
+
+#ifndef BookSide_hpp
+#define BookSide_hpp
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <type_traits>
+#include <utility>
+
+#include "Order.hpp"
+
+/*
+ * A book side maps prices to `PriceLevel`s and iterates over the non-empty levels in priority
+ * order according to `Compare` (`std::greater` for buys, `std::less` for sells). It is a template
+ * `BookSide<PriceT, Compare>` providing the subset of the `std::map` interface used by the engine:
+ * `key_type`, `key_comp()`, `empty()`, `begin()`/`end()`, `rbegin()`/`rend()`, `find()`,
+ * `operator[]` and `erase(iterator)`, with `first`/`second` access to price and level.
+ * A side may also provide `bool canInsert(const key_type&) const` to bound the prices it accepts.
+ */
+
+/** @brief Book side backed by an ordered map; the general purpose default */
+template <typename PriceT, typename Compare>
+using MapBookSide = std::map<PriceT, PriceLevel, Compare>;
+
+/**
+ * @brief Book side backed by a dense ladder with one level per tick
+ * @discussion Levels for every tick between the lowest and highest open price are stored contiguously,
+ * so finding a level is an index computation. Both ends of the ladder always hold open orders; empty
+ * levels at the ends are trimmed on erase. Meant for narrow-tick instruments: prices that would make the
+ * ladder span more than `MAX_SPAN` ticks are rejected by `canInsert()`. `PriceT` must expose an integer
+ * `ticks` member and be constructible from it (see `TickPrice`).
+ */
+template <typename PriceT, typename Compare>
+class LadderBookSide {
+public:
+    using key_type = PriceT;
+    using mapped_type = PriceLevel;
+    using value_type = std::pair<const PriceT, PriceLevel>;
+    using key_compare = Compare;
+
+    /** @brief Maximum number of ticks between the lowest and highest open price */
+    static constexpr uint64_t MAX_SPAN = uint64_t(1) << 20;
+
+private:
+    using Levels = std::deque<value_type>;
+
+    /** @brief Whether priority order is ascending price */
+    static constexpr bool ascending = std::is_same_v<Compare, std::less<PriceT>>;
+    static_assert(ascending || std::is_same_v<Compare, std::greater<PriceT>>, "LadderBookSide supports std::less and std::greater");
+
+    /** @brief One level per tick, lowest price first */
+    Levels levels;
+
+    /**
+     * @brief Iterator over the open levels in priority order
+     */
+    template <bool Const>
+    class Iterator {
+        using LevelsPtr = std::conditional_t<Const, const Levels*, Levels*>;
+
+        LevelsPtr levels;
+        /** @brief Index into `levels`; one past either end means end() */
+        ptrdiff_t index;
+
+        /** @brief Move `index` by `step`, skipping empty levels */
+        void advance(ptrdiff_t step)
+        {
+            do {
+                index += step;
+            } while (index >= 0 && index < (ptrdiff_t)levels->size() && (*levels)[index].second.live == 0);
+        }
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = LadderBookSide::value_type;
+        using difference_type = ptrdiff_t;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+        Iterator() = default;
+        Iterator(LevelsPtr _levels, ptrdiff_t _index)
+            : levels(_levels)
+            , index(_index)
+        {
+        }
+
+        reference operator*() const { return (*levels)[index]; }
+        pointer operator->() const { return &(*levels)[index]; }
+
+        Iterator& operator++()
+        {
+            advance(ascending ? 1 : -1);
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+        Iterator& operator--()
+        {
+            advance(ascending ? -1 : 1);
+            return *this;
+        }
+        Iterator operator--(int)
+        {
+            Iterator old = *this;
+            --*this;
+            return old;
+        }
+
+        bool operator==(const Iterator& other) const { return index == other.index; }
+    };
+
+    /** @brief Index of the level for `price`, which must be within the ladder */
+    size_t indexOf(const PriceT& price) const { return price.ticks - levels.front().first.ticks; }
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    key_compare key_comp() const { return Compare(); }
+    bool empty() const { return levels.empty(); }
+
+    iterator begin() { return iterator(&levels, ascending ? 0 : (ptrdiff_t)levels.size() - 1); }
+    iterator end() { return iterator(&levels, ascending ? (ptrdiff_t)levels.size() : -1); }
+    const_iterator begin() const { return const_iterator(&levels, ascending ? 0 : (ptrdiff_t)levels.size() - 1); }
+    const_iterator end() const { return const_iterator(&levels, ascending ? (ptrdiff_t)levels.size() : -1); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    /** @brief Whether a level for `price` fits in the ladder */
+    bool canInsert(const PriceT& price) const
+    {
+        if (levels.empty()) {
+            return true;
+        }
+        uint64_t low = std::min(price.ticks, levels.front().first.ticks);
+        uint64_t high = std::max(price.ticks, levels.back().first.ticks);
+        return high - low < MAX_SPAN;
+    }
+
+    /**
+     * @brief Get the level for `price`, extending the ladder if needed
+     * @discussion An order must be pushed onto the returned level before the side is used again.
+     */
+    PriceLevel& operator[](const PriceT& price)
+    {
+        if (levels.empty()) {
+            levels.emplace_back(price, PriceLevel());
+        }
+        for (uint64_t ticks = levels.front().first.ticks; ticks > price.ticks; --ticks) {
+            levels.emplace_front(PriceT(ticks - 1), PriceLevel());
+        }
+        for (uint64_t ticks = levels.back().first.ticks; ticks < price.ticks; ++ticks) {
+            levels.emplace_back(PriceT(ticks + 1), PriceLevel());
+        }
+        return levels[indexOf(price)].second;
+    }
+
+    iterator find(const PriceT& price)
+    {
+        if (levels.empty() || price.ticks < levels.front().first.ticks || price.ticks > levels.back().first.ticks) {
+            return end();
+        }
+        size_t index = indexOf(price);
+        if (levels[index].second.live == 0) {
+            return end();
+        }
+        return iterator(&levels, index);
+    }
+
+    /** @brief Clear a level that no longer has open orders */
+    void erase(iterator it)
+    {
+        it->second = PriceLevel();
+        while (!levels.empty() && levels.front().second.live == 0) {
+            levels.pop_front();
+        }
+        while (!levels.empty() && levels.back().second.live == 0) {
+            levels.pop_back();
+        }
+    }
+};
+
+#endif /* BookSide_hpp */
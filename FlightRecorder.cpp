@@ -0,0 +1,135 @@
+//
+//  FlightRecorder.cpp
+//  simple_cross
+//
+//  Always-on binary trace of matching decisions.
+//
+
+#include "FlightRecorder.hpp"
+
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+
+/** @brief Registered rings; slots are filled in order and never cleared */
+static std::atomic<FlightRecorder::Ring*> rings[FlightRecorder::MAX_RINGS];
+/** @brief Number of slots claimed in `rings` */
+static std::atomic<size_t> ringCount { 0 };
+
+/** @brief Clock anchors taken when the first ring is attached */
+static std::atomic<uint64_t> startTsc { 0 };
+static std::atomic<uint64_t> startNs { 0 };
+
+/** @brief Dump path used by the signal handlers */
+static char signalDumpPath[4096];
+
+/** @brief Monotonic clock in nanoseconds; async-signal-safe */
+static uint64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+FlightRecorder::Ring* FlightRecorder::attach()
+{
+    size_t slot = ringCount.fetch_add(1, std::memory_order_relaxed);
+    if (slot >= MAX_RINGS) {
+        threadUntraced = true;
+        return nullptr;
+    }
+    if (slot == 0) {
+        startNs.store(monotonicNs(), std::memory_order_relaxed);
+        startTsc.store(timestamp(), std::memory_order_relaxed);
+    }
+    Ring* ring = new Ring();
+    rings[slot].store(ring, std::memory_order_release);
+    threadRing = ring;
+    return ring;
+}
+
+/** @brief Write all of `size` bytes; async-signal-safe */
+static bool writeAll(int fd, const void* data, size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+bool FlightRecorder::dump(const char* path)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    /* only rings that finished registering are dumped */
+    Ring* snapshot[MAX_RINGS];
+    uint32_t count = 0;
+    size_t claimed = ringCount.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < claimed && i < MAX_RINGS; ++i) {
+        Ring* ring = rings[i].load(std::memory_order_acquire);
+        if (ring != nullptr) {
+            snapshot[count++] = ring;
+        }
+    }
+
+    TraceFileHeader header;
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.recordSize = sizeof(TraceRecord);
+    header.rings = count;
+    header.startTsc = startTsc.load(std::memory_order_relaxed);
+    header.startNs = startNs.load(std::memory_order_relaxed);
+    header.dumpNs = monotonicNs();
+    header.dumpTsc = timestamp();
+    bool ok = writeAll(fd, &header, sizeof(header));
+
+    for (uint32_t i = 0; i < count && ok; ++i) {
+        Ring* ring = snapshot[i];
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t first = head > CAPACITY ? head - CAPACITY : 0;
+        TraceRingHeader ringHeader { i, (uint32_t)(head - first), head };
+        ok = writeAll(fd, &ringHeader, sizeof(ringHeader));
+
+        /* oldest records first: from the head to the end of the buffer, then from its start */
+        size_t start = first & (CAPACITY - 1);
+        size_t tail = std::min<uint64_t>(head - first, CAPACITY - start);
+        ok = ok && writeAll(fd, &ring->records[start], tail * sizeof(TraceRecord));
+        ok = ok && writeAll(fd, &ring->records[0], (head - first - tail) * sizeof(TraceRecord));
+    }
+
+    return close(fd) == 0 && ok;
+}
+
+/** @brief Dump, then re-raise crash signals with their default action */
+static void signalHandler(int sig)
+{
+    FlightRecorder::dump(signalDumpPath);
+    if (sig != SIGUSR1) {
+        signal(sig, SIG_DFL);
+        raise(sig);
+    }
+}
+
+void FlightRecorder::installSignalHandlers(const char* path)
+{
+    strncpy(signalDumpPath, path, sizeof(signalDumpPath) - 1);
+    signalDumpPath[sizeof(signalDumpPath) - 1] = '\0';
+
+    struct sigaction action {};
+    action.sa_handler = signalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    for (int sig : { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT, SIGUSR1 }) {
+        sigaction(sig, &action, nullptr);
+    }
+}
@@ -0,0 +1,194 @@
+//
+//  FlightRecorder.hpp
+//  simple_cross
+//
+//  Always-on binary trace of matching decisions.
+//
+
+#ifndef FlightRecorder_hpp
+#define FlightRecorder_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+#include "Order.hpp"
+
+/**
+ * @brief Kinds of trace records
+ */
+enum class TraceEvent : uint8_t {
+    /** @brief An input line was parsed. `action` is the action character; OID, quantity and price when present. */
+    ActionDecoded = 1,
+    /** @brief The matching loop looked at a price level. `quantity` is the incoming open quantity, `other` the number of open orders at the level. */
+    LevelTouched,
+    /** @brief The matching loop considered a resting order. `other` is the resting OID, `quantity` its open quantity. */
+    MatchAttempted,
+    /** @brief An execution. `oid` is the incoming (or buy) order, `other` the resting (or sell) order. */
+    Fill,
+    /** @brief The matching loop stopped. `other` is a `TraceStopReason`, `quantity` the incoming open quantity. */
+    MatchStopped,
+    /** @brief An order was added to the book. `action` is the side ('B' or 'S'). */
+    Insert,
+    /** @brief A resting order was canceled. `action` is the side ('B' or 'S'). */
+    Cancel,
+    /** @brief A call auction picked a clearing price. `other` is the executed volume. */
+    Auction
+};
+
+/**
+ * @brief Why the matching loop stopped
+ */
+enum class TraceStopReason : uint32_t {
+    /** @brief Incoming order was fully filled */
+    Filled,
+    /** @brief Opposite side of the book is empty */
+    BookEmpty,
+    /** @brief Best opposite price does not cross the incoming price */
+    PriceNotCrossed
+};
+
+/**
+ * @brief Binary trace record; 32 bytes
+ */
+struct TraceRecord {
+    /** @brief Timestamp counter when the event was recorded */
+    uint64_t tsc;
+    /** @brief Price in 0.00001 ticks, 0 if not applicable */
+    uint64_t price;
+    /** @brief Primary order ID, 0 if not applicable */
+    OID oid;
+    /** @brief Event-specific secondary value (see `TraceEvent`) */
+    uint32_t other;
+    /** @brief Event-specific quantity (see `TraceEvent`) */
+    uint16_t quantity;
+    /** @brief Event kind */
+    TraceEvent event;
+    /** @brief Action or side character */
+    char action;
+    /** @brief Low 32 bits of the record's position in its ring; written last, so a mismatch marks a torn record */
+    uint32_t seq;
+};
+
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord should fit in 32 bytes");
+
+/** @brief Magic bytes at the start of a trace dump */
+constexpr char TRACE_MAGIC[8] = { 'S', 'X', 'T', 'R', 'A', 'C', 'E', '1' };
+
+/**
+ * @brief Header of a trace dump file
+ * @discussion Followed by `rings` blocks, each a `TraceRingHeader` and its records oldest first.
+ * The two clock anchors let a decoder convert timestamp counter values to nanoseconds.
+ */
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t recordSize;
+    uint32_t rings;
+    /** @brief Timestamp counter and monotonic clock (ns) when recording started */
+    uint64_t startTsc;
+    uint64_t startNs;
+    /** @brief Timestamp counter and monotonic clock (ns) when the dump was written */
+    uint64_t dumpTsc;
+    uint64_t dumpNs;
+};
+
+/**
+ * @brief Header of one thread's ring in a trace dump
+ */
+struct TraceRingHeader {
+    /** @brief Index of the ring (one per recording thread) */
+    uint32_t ring;
+    /** @brief Number of records that follow */
+    uint32_t count;
+    /** @brief Total number of records ever written to the ring */
+    uint64_t written;
+};
+
+/**
+ * @brief Fixed-size, lock-free flight recorder
+ * @discussion Each thread records into its own ring of `CAPACITY` records, allocated on its first event,
+ * so recording is a thread-local load, a timestamp read and a 32-byte store with no atomic read-modify-write.
+ * The oldest records are overwritten once a ring is full. Rings are never freed, so a dump after a thread
+ * exits still includes its events. At most `MAX_RINGS` threads record; later threads are not traced.
+ *
+ * Dumps use only async-signal-safe calls, so they can be written from a crash signal handler.
+ * Records being written by another thread while dumping may be torn; the decoder detects them by `seq`.
+ */
+class FlightRecorder {
+public:
+    /** @brief Records per ring; a power of two */
+    static constexpr size_t CAPACITY = size_t(1) << 16;
+    /** @brief Maximum number of recording threads */
+    static constexpr size_t MAX_RINGS = 64;
+
+    struct Ring {
+        /** @brief Number of records written so far; the next record goes to `head % CAPACITY` */
+        std::atomic<uint64_t> head { 0 };
+        TraceRecord records[CAPACITY];
+    };
+
+private:
+    /** @brief Ring of the calling thread, or nullptr before its first event */
+    static inline thread_local Ring* threadRing = nullptr;
+    /** @brief Set once the calling thread could not get a ring */
+    static inline thread_local bool threadUntraced = false;
+
+    /** @brief Allocate and register a ring for the calling thread */
+    static Ring* attach();
+
+public:
+    /** @brief Read the timestamp counter */
+    static uint64_t timestamp()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    /** @brief Record an event on the calling thread's ring */
+    static void record(TraceEvent event, char action, OID oid, uint32_t other, uint16_t quantity, uint64_t price)
+    {
+        Ring* ring = threadRing;
+        if (ring == nullptr) {
+            if (threadUntraced || (ring = attach()) == nullptr) {
+                return;
+            }
+        }
+        uint64_t index = ring->head.load(std::memory_order_relaxed);
+        TraceRecord& record = ring->records[index & (CAPACITY - 1)];
+        record.tsc = timestamp();
+        record.price = price;
+        record.oid = oid;
+        record.other = other;
+        record.quantity = quantity;
+        record.event = event;
+        record.action = action;
+        std::atomic_signal_fence(std::memory_order_release);
+        record.seq = (uint32_t)index;
+        ring->head.store(index + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Write every ring to `path`
+     * @discussion Async-signal-safe.
+     * @return Whether the dump was written completely
+     */
+    static bool dump(const char* path);
+
+    /**
+     * @brief Dump to `path` on crash signals (SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT) and on SIGUSR1
+     * @discussion After a crash dump the signal is re-raised with its default action; SIGUSR1 only dumps.
+     * `path` is copied.
+     */
+    static void installSignalHandlers(const char* path);
+};
+
+#endif /* FlightRecorder_hpp */
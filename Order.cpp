@@ -16,14 +16,52 @@ Order::Order(OID _oid, std::string _symbol, OrderSide _side, uint16_t _quantity,
 {
 }
 
-std::strong_ordering
-Order::operator<=>(const Order& other) const
+uint64_t PriceLevel::push(Order* order, uint16_t quantity)
 {
-    /* Compare on price if it is different */
-    if (price != other.price) {
-        /* Buy orders should be ordered greatest to least,
-         * sell orders are ordered least to greatest */
-        return side == OrderSide::Buy ? other.price <=> price : price <=> other.price;
+    orders.push_back(RestingOrder { order, order->oid, quantity });
+    live++;
+    return base + orders.size() - 1;
+}
+
+RestingOrder& PriceLevel::at(uint64_t seq)
+{
+    return orders[seq - base];
+}
+
+RestingOrder& PriceLevel::front()
+{
+    while (orders[head].quantity == 0) {
+        head++;
+    }
+    return orders[head];
+}
+
+void PriceLevel::retireFront()
+{
+    auto& resting = orders[head];
+    resting.quantity = 0;
+    resting.order->quantity = 0;
+    resting.order->book_seq = std::nullopt;
+    head++;
+    live--;
+}
+
+uint64_t PriceLevel::openQuantity() const
+{
+    uint64_t total = 0;
+    for (size_t i = head; i < orders.size(); ++i) {
+        total += orders[i].quantity;
+    }
+    return total;
+}
+
+void PriceLevel::compact()
+{
+    /* only pay for the move once the consumed prefix is at least half of the level */
+    if (head * 2 < orders.size()) {
+        return;
     }
-    return oid <=> other.oid;
+    orders.erase(orders.begin(), orders.begin() + head);
+    base += head;
+    head = 0;
 }
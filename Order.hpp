@@ -8,11 +8,10 @@
 #ifndef Order_hpp
 #define Order_hpp
 
-#include <compare>
 #include <cstdint>
 #include <optional>
-#include <set>
 #include <string>
+#include <vector>
 
 #include "Price.hpp"
 
@@ -30,6 +29,9 @@ using OID = uint32_t;
 
 /**
  * @brief Data structure representing an order
+ * @discussion This is the cold part of an order: metadata that the matching loop does not need.
+ * While the order is resting, its open quantity lives in the compact `RestingOrder` record in the
+ * order book; `quantity` here is only updated when the order is fully filled.
  */
 struct Order {
     /** @brief Order ID */
@@ -38,18 +40,69 @@ struct Order {
     std::string symbol;
     /** @brief Order side (either buy or sell) */
     OrderSide side;
-    /** @brief Order quantity */
+    /** @brief Order quantity (0 once fully filled) */
     uint16_t quantity;
     /** @brief Order price */
     Price price;
 
-    /** @brief Iterator referencing where this order is stored in the order book. */
-    std::optional<std::set<Order*>::iterator> book_iter;
+    /** @brief Sequence number of this order's record within its price level, if it is resting in the order book. */
+    std::optional<uint64_t> book_seq;
 
     Order(OID oid, std::string symbol, OrderSide side, uint16_t quantity, Price price);
+};
+
+/**
+ * @brief Hot part of a resting order
+ * @discussion Packed into 16 bytes so that the matching loop reads contiguous memory when sweeping
+ * a price level. The price is implied by the level the record is stored in.
+ */
+struct RestingOrder {
+    /** @brief Cold metadata for this order */
+    Order* order;
+    /** @brief Order ID */
+    OID oid;
+    /** @brief Open quantity (0 once filled or canceled) */
+    uint16_t quantity;
+};
+
+static_assert(sizeof(RestingOrder) == 16, "RestingOrder should fit in 16 bytes");
+
+/**
+ * @brief Resting orders at a single price
+ * @discussion Orders are stored in arrival (FIFO) order as packed `RestingOrder` records. Filled and
+ * canceled orders are left in place with a quantity of 0 and skipped by the matching loop; the
+ * consumed prefix is compacted away once it makes up more than half of the records.
+ */
+struct PriceLevel {
+    /** @brief Resting orders in arrival order, including filled/canceled records */
+    std::vector<RestingOrder> orders;
+    /** @brief Index of the first record that may still be open */
+    size_t head = 0;
+    /** @brief Sequence number of `orders[0]` */
+    uint64_t base = 0;
+    /** @brief Number of open records */
+    size_t live = 0;
+
+    /**
+     * @brief Append an order to the back of the level
+     * @return Sequence number of the new record
+     */
+    uint64_t push(Order* order, uint16_t quantity);
+
+    /** @brief Get the record with the given sequence number */
+    RestingOrder& at(uint64_t seq);
+
+    /** @brief Get the first open record, skipping filled/canceled ones. The level must have open records. */
+    RestingOrder& front();
+
+    /** @brief Retire the first open record once it has been fully filled */
+    void retireFront();
+
+    /** @brief Total open quantity at this price */
+    uint64_t openQuantity() const;
 
-    /** @brief Compare against another `Order` instance */
-    std::strong_ordering operator<=>(const Order& other) const;
+    /** @brief Drop the consumed prefix if it dominates the level */
+    void compact();
 };
 
 #endif /* Order_hpp */
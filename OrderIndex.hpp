@@ -0,0 +1,91 @@
+//
+//  OrderIndex.hpp
+//  simple_cross
+//
+//  OID index policies for `BasicSimpleCross`.
+//
+
+#ifndef OrderIndex_hpp
+#define OrderIndex_hpp
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Order.hpp"
+
+/*
+ * An OID index owns every order the engine has accepted and maps OIDs to them. Order addresses
+ * must stay stable for the lifetime of the index, since resting records point at them.
+ *
+ * Required interface:
+ *   std::pair<Order*, bool> emplace(Order&& order);  // insert unless the OID exists; returns the order with that OID
+ *   Order* find(OID oid);                            // nullptr if the OID was never accepted
+ */
+
+/**
+ * @brief OID index backed by an ordered map
+ * @discussion General purpose default; memory is proportional to the number of orders regardless of OID spread.
+ */
+class MapOrderIndex {
+    /** @brief Mapping from order ID to order */
+    std::map<OID, Order> orders;
+
+public:
+    std::pair<Order*, bool> emplace(Order&& order)
+    {
+        auto [it, inserted] = orders.emplace(order.oid, std::move(order));
+        return { &it->second, inserted };
+    }
+
+    Order* find(OID oid)
+    {
+        auto it = orders.find(oid);
+        return it == orders.end() ? nullptr : &it->second;
+    }
+};
+
+/**
+ * @brief OID index backed by a paged array indexed directly by OID
+ * @discussion Lookups are two array accesses. Pages of `PAGE_SIZE` slots are allocated on first use,
+ * so this is only suitable when OIDs are dense (e.g. assigned sequentially).
+ */
+class DenseOrderIndex {
+    static constexpr size_t PAGE_BITS = 12;
+    static constexpr size_t PAGE_SIZE = size_t(1) << PAGE_BITS;
+
+    /** @brief Pages of order slots, indexed by `oid >> PAGE_BITS` */
+    std::vector<std::unique_ptr<std::optional<Order>[]>> pages;
+
+public:
+    std::pair<Order*, bool> emplace(Order&& order)
+    {
+        size_t page = order.oid >> PAGE_BITS;
+        if (page >= pages.size()) {
+            pages.resize(page + 1);
+        }
+        if (!pages[page]) {
+            pages[page] = std::make_unique<std::optional<Order>[]>(PAGE_SIZE);
+        }
+        auto& slot = pages[page][order.oid & (PAGE_SIZE - 1)];
+        if (slot) {
+            return { &*slot, false };
+        }
+        slot.emplace(std::move(order));
+        return { &*slot, true };
+    }
+
+    Order* find(OID oid)
+    {
+        size_t page = oid >> PAGE_BITS;
+        if (page >= pages.size() || !pages[page]) {
+            return nullptr;
+        }
+        auto& slot = pages[page][oid & (PAGE_SIZE - 1)];
+        return slot ? &*slot : nullptr;
+    }
+};
+
+#endif /* OrderIndex_hpp */
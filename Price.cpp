@@ -94,3 +94,22 @@ to_string(const Price& p)
     ss << p.intPart << "." << std::setfill('0') << std::setw(FRAC_PART_DIGITS) << p.fracPart;
     return ss.str();
 }
+
+/** @brief Number of ticks in one unit of price */
+constexpr uint64_t TICKS_PER_UNIT = 100000;
+
+TickPrice::TickPrice(uint64_t _ticks)
+    : ticks(_ticks)
+{
+}
+
+TickPrice::TickPrice(const Price& price)
+    : ticks(price.intPart * TICKS_PER_UNIT + price.fracPart)
+{
+}
+
+std::string
+to_string(const TickPrice& p)
+{
+    return to_string(Price { (uint32_t)(p.ticks / TICKS_PER_UNIT), (uint32_t)(p.ticks % TICKS_PER_UNIT) });
+}
@@ -0,0 +1,173 @@
+//
+//  Profiler.cpp
+//  simple_cross
+//
+//  Optional per-action profiling with hardware performance counters.
+//
+
+#include "Profiler.hpp"
+
+#include <chrono>
+#include <cctype>
+#include <iomanip>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+/**
+ * @brief Open one hardware counter for the calling thread
+ * @param config `PERF_COUNT_HW_*` event
+ * @param group Group leader file descriptor, or -1 to open a new (disabled) group leader
+ * @return File descriptor, or -1 if the counter is not available
+ */
+static int openCounter(uint64_t config, int group)
+{
+    perf_event_attr attr {};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+#endif
+
+PerfCounters::PerfCounters()
+{
+    fds.fill(-1);
+#ifdef __linux__
+    fds[Cycles] = openCounter(PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (fds[Cycles] < 0) {
+        /* no leader, no group */
+        return;
+    }
+    fds[Instructions] = openCounter(PERF_COUNT_HW_INSTRUCTIONS, fds[Cycles]);
+    fds[CacheMisses] = openCounter(PERF_COUNT_HW_CACHE_MISSES, fds[Cycles]);
+    fds[BranchMisses] = openCounter(PERF_COUNT_HW_BRANCH_MISSES, fds[Cycles]);
+    ioctl(fds[Cycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[Cycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+    /* close members before the leader */
+    for (int i = CounterCount - 1; i >= 0; --i) {
+        if (fds[i] >= 0) {
+            close(fds[i]);
+        }
+    }
+#endif
+}
+
+PerfCounters::Values PerfCounters::read() const
+{
+    Values values {};
+#ifdef __linux__
+    if (fds[Cycles] < 0) {
+        return values;
+    }
+    /* group read format: number of counters, then values of the opened counters in open order */
+    uint64_t buffer[1 + CounterCount];
+    if (::read(fds[Cycles], buffer, sizeof(buffer)) < (ssize_t)sizeof(uint64_t)) {
+        return values;
+    }
+    size_t next = 1;
+    for (size_t i = 0; i < CounterCount && next <= buffer[0]; ++i) {
+        if (fds[i] >= 0) {
+            values[i] = buffer[next++];
+        }
+    }
+#endif
+    return values;
+}
+
+ActionProfiler::Metrics ActionProfiler::sample() const
+{
+    Metrics metrics;
+    metrics[0] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    auto values = counters.read();
+    for (size_t i = 0; i < PerfCounters::CounterCount; ++i) {
+        metrics[1 + i] = values[i];
+    }
+    return metrics;
+}
+
+void ActionProfiler::close()
+{
+    Metrics now = sample();
+    auto& totals = current[(size_t)phase];
+    for (size_t i = 0; i < METRICS; ++i) {
+        totals[i] += now[i] - phaseStart[i];
+    }
+    phaseStart = now;
+}
+
+void ActionProfiler::start()
+{
+    current = {};
+    phase = ProfilePhase::Parse;
+    phaseStart = sample();
+}
+
+void ActionProfiler::enter(ProfilePhase next)
+{
+    if (next == phase) {
+        return;
+    }
+    close();
+    phase = next;
+}
+
+void ActionProfiler::finish(char action)
+{
+    close();
+    auto& actionStats = stats[action];
+    actionStats.count++;
+    for (size_t p = 0; p < (size_t)ProfilePhase::Count; ++p) {
+        for (size_t i = 0; i < METRICS; ++i) {
+            actionStats.phases[p][i] += current[p][i];
+        }
+    }
+}
+
+void ActionProfiler::report(std::ostream& out) const
+{
+    static const char* phaseNames[] = { "parse", "match", "format" };
+    static const char* metricNames[] = { "ns", "cycles", "instrs", "cache-miss", "branch-miss" };
+    constexpr int WIDTH = 12;
+
+    out << "Per-action profile (averages per action)" << std::endl;
+    if (!counters.available(PerfCounters::Cycles)) {
+        out << "Hardware counters unavailable; reporting wall-clock time only" << std::endl;
+    }
+    out << std::left << std::setw(8) << "action" << std::setw(8) << "phase" << std::right << std::setw(WIDTH) << "count";
+    for (const char* name : metricNames) {
+        out << std::setw(WIDTH) << name;
+    }
+    out << std::endl;
+
+    for (const auto& [action, actionStats] : stats) {
+        std::string label = std::isgraph((unsigned char)action) ? std::string(1, action) : "(none)";
+        for (size_t p = 0; p < (size_t)ProfilePhase::Count; ++p) {
+            out << std::left << std::setw(8) << label << std::setw(8) << phaseNames[p] << std::right << std::setw(WIDTH) << actionStats.count;
+            for (size_t i = 0; i < METRICS; ++i) {
+                if (i > 0 && !counters.available((PerfCounters::Counter)(i - 1))) {
+                    out << std::setw(WIDTH) << "n/a";
+                } else {
+                    out << std::setw(WIDTH) << std::fixed << std::setprecision(1) << (double)actionStats.phases[p][i] / (double)actionStats.count;
+                }
+            }
+            out << std::endl;
+        }
+    }
+}
@@ -0,0 +1,144 @@
+//
+//  Profiler.hpp
+//  simple_cross
+//
+//  Optional per-action profiling with hardware performance counters.
+//
+
+#ifndef Profiler_hpp
+#define Profiler_hpp
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <map>
+
+/**
+ * @brief Phases of `SimpleCross::action()` that costs are attributed to
+ */
+enum class ProfilePhase {
+    /** @brief Parsing and validating the input line */
+    Parse,
+    /** @brief Order book operations: matching, resting, canceling, uncrossing */
+    Match,
+    /** @brief Rendering result strings */
+    Format,
+    Count
+};
+
+/**
+ * @brief Group of hardware performance counters for the calling thread
+ * @discussion Opens cycles, instructions, cache misses and branch misses with Linux `perf_event_open`
+ * as one group, so all counters are read together. Counters that cannot be opened (e.g. in containers,
+ * on non-Linux systems or when `perf_event_paranoid` forbids it) are reported as unavailable.
+ */
+class PerfCounters {
+public:
+    enum Counter {
+        Cycles,
+        Instructions,
+        CacheMisses,
+        BranchMisses,
+        CounterCount
+    };
+
+    /** @brief Counter values; only meaningful for available counters */
+    using Values = std::array<uint64_t, CounterCount>;
+
+private:
+    /** @brief File descriptor of each counter, -1 if unavailable. `fds[Cycles]` is the group leader. */
+    std::array<int, CounterCount> fds;
+
+public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /** @brief Whether `counter` could be opened */
+    bool available(Counter counter) const { return fds[counter] >= 0; }
+
+    /** @brief Read the current value of every available counter */
+    Values read() const;
+};
+
+/**
+ * @brief Attributes wall-clock time and hardware counters to the phases of each action type
+ * @discussion The engine calls `start()` when an action begins, `enter()` at each phase change and
+ * `finish()` with the action character when it returns. Each phase change costs a counter read
+ * (one system call), so profiling is meant for diagnosis rather than production runs.
+ */
+class ActionProfiler {
+    /** @brief Number of metrics per phase: wall-clock nanoseconds followed by the counters */
+    static constexpr size_t METRICS = 1 + PerfCounters::CounterCount;
+    using Metrics = std::array<uint64_t, METRICS>;
+
+    struct ActionStats {
+        /** @brief Number of actions of this type */
+        uint64_t count = 0;
+        /** @brief Totals per phase */
+        std::array<Metrics, (size_t)ProfilePhase::Count> phases {};
+    };
+
+    PerfCounters counters;
+
+    /** @brief Totals per action character */
+    std::map<char, ActionStats> stats;
+
+    /** @brief Totals for the action in progress */
+    std::array<Metrics, (size_t)ProfilePhase::Count> current;
+    /** @brief Phase in progress */
+    ProfilePhase phase = ProfilePhase::Parse;
+    /** @brief Metrics sampled when the phase in progress began */
+    Metrics phaseStart;
+
+    /** @brief Sample wall-clock time and counters */
+    Metrics sample() const;
+
+    /** @brief Add the metrics since the phase in progress began to it */
+    void close();
+
+public:
+    /** @brief Begin an action, in the parse phase */
+    void start();
+
+    /** @brief Switch to `next` phase */
+    void enter(ProfilePhase next);
+
+    /** @brief End the action in progress and attribute it to `action` */
+    void finish(char action);
+
+    /** @brief Print a summary table of average cost per action type and phase */
+    void report(std::ostream& out) const;
+};
+
+/**
+ * @brief Scope guard that profiles one action, if a profiler is attached
+ * @discussion `action` is read when the scope ends, so it may be assigned once the line is parsed.
+ */
+class ProfileScope {
+    ActionProfiler* profiler;
+    const char& action;
+
+public:
+    ProfileScope(ActionProfiler* _profiler, const char& _action)
+        : profiler(_profiler)
+        , action(_action)
+    {
+        if (profiler) {
+            profiler->start();
+        }
+    }
+
+    ~ProfileScope()
+    {
+        if (profiler) {
+            profiler->finish(action);
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#endif /* Profiler_hpp */
@@ -0,0 +1,107 @@
+//
+//  Replay.cpp
+//  simple_cross
+//
+//  Replay driver for running many independent sessions in parallel.
+//
+
+#include "Replay.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <thread>
+
+#include "WorkStealingPool.hpp"
+#include "simple_cross.hpp"
+
+ReplayStats replaySession(std::istream& actions, std::ostream& out, ActionProfiler* profiler, size_t renderThreads)
+{
+    ReplayStats stats;
+    SimpleCross scross;
+    scross.setProfiler(profiler);
+    if (renderThreads > 0) {
+        scross.setRenderThreads(renderThreads);
+    }
+    std::string line;
+    while (std::getline(actions, line)) {
+        stats.results += scross.action(line, out);
+        stats.actions++;
+    }
+    return stats;
+}
+
+int replay(const std::string& outputDir, const std::vector<std::string>& inputs)
+{
+    namespace fs = std::filesystem;
+
+    std::error_code error;
+    fs::create_directories(outputDir, error);
+    if (error) {
+        std::cerr << "Failed to create " << outputDir << ": " << error.message() << std::endl;
+        return 1;
+    }
+
+    /* outputs are named after the input file name, so those must be unique */
+    std::vector<std::string> outputs;
+    std::set<std::string> names;
+    for (const auto& input : inputs) {
+        std::string name = fs::path(input).filename().string();
+        if (!names.insert(name).second) {
+            std::cerr << "Duplicate session name " << name << std::endl;
+            return 1;
+        }
+        outputs.push_back((fs::path(outputDir) / (name + ".out")).string());
+    }
+
+    WorkStealingPool pool(std::thread::hardware_concurrency());
+    std::vector<ReplayStats> stats(inputs.size());
+    std::vector<std::string> errors(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        pool.submit([&, i]() {
+            auto actions = std::ifstream(inputs[i], std::ios::in);
+            if (actions.fail()) {
+                errors[i] = "Failed to read " + inputs[i];
+                return;
+            }
+            auto out = std::ofstream(outputs[i], std::ios::out | std::ios::trunc);
+            if (out.fail()) {
+                errors[i] = "Failed to write " + outputs[i];
+                return;
+            }
+            /* sessions already run in parallel, so render their P dumps serially */
+            stats[i] = replaySession(actions, out, nullptr, 1);
+            out.flush();
+            if (out.fail()) {
+                errors[i] = "Failed to write " + outputs[i];
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    pool.run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    int status = 0;
+    ReplayStats total;
+    size_t replayed = 0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (!errors[i].empty()) {
+            std::cerr << errors[i] << std::endl;
+            status = 1;
+            continue;
+        }
+        total.actions += stats[i].actions;
+        total.results += stats[i].results;
+        replayed++;
+    }
+
+    std::cout << "Replayed " << replayed << " of " << inputs.size() << " sessions on " << pool.size() << " threads in "
+              << std::fixed << std::setprecision(3) << elapsed.count() << " s: "
+              << total.actions << " actions, " << total.results << " results, "
+              << std::setprecision(0) << (elapsed.count() > 0 ? total.actions / elapsed.count() : 0) << " actions/s" << std::endl;
+    return status;
+}
@@ -0,0 +1,47 @@
+//
+//  Replay.hpp
+//  simple_cross
+//
+//  Replay driver for running many independent sessions in parallel.
+//
+
+#ifndef Replay_hpp
+#define Replay_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Statistics for one replayed session
+ */
+struct ReplayStats {
+    /** @brief Number of actions (input lines) processed */
+    uint64_t actions = 0;
+    /** @brief Number of result lines written */
+    uint64_t results = 0;
+};
+
+class ActionProfiler;
+
+/**
+ * @brief Run one session: feed every line of `actions` to a fresh `SimpleCross` and write the results to `out`
+ * @param profiler Profiler to attribute the session's cost to, if any
+ * @param renderThreads Threads used to render `P` dumps, 0 for the engine default
+ */
+ReplayStats replaySession(std::istream& actions, std::ostream& out, ActionProfiler* profiler = nullptr, size_t renderThreads = 0);
+
+/**
+ * @brief Replay many independent sessions in parallel
+ * @discussion Each input file is run through its own `SimpleCross` instance on a work-stealing pool
+ * sized to the number of cores. The output of `dir/name` is written to `outputDir/name.out`.
+ * Aggregate throughput is printed to standard output once all sessions are done.
+ * @param outputDir Directory to write session outputs to; created if it does not exist
+ * @param inputs Input files, one per session
+ * @return Process exit code: 0 if every session was replayed
+ */
+int replay(const std::string& outputDir, const std::vector<std::string>& inputs);
+
+#endif /* Replay_hpp */
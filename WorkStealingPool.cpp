@@ -0,0 +1,68 @@
+//
+//  WorkStealingPool.cpp
+//  simple_cross
+//
+//  Fixed-size work-stealing thread pool.
+//
+
+#include "WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <thread>
+
+WorkStealingPool::WorkStealingPool(size_t threads)
+{
+    for (size_t i = 0; i < std::max<size_t>(threads, 1); ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+}
+
+void WorkStealingPool::submit(std::function<void()> task)
+{
+    auto& worker = *workers[nextWorker];
+    nextWorker = (nextWorker + 1) % workers.size();
+    std::lock_guard<std::mutex> guard(worker.lock);
+    worker.tasks.push_back(std::move(task));
+}
+
+bool WorkStealingPool::take(size_t self, std::function<void()>& task)
+{
+    /* own deque first, newest task */
+    {
+        auto& worker = *workers[self];
+        std::lock_guard<std::mutex> guard(worker.lock);
+        if (!worker.tasks.empty()) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            return true;
+        }
+    }
+    /* then steal the oldest task of another worker */
+    for (size_t i = 1; i < workers.size(); ++i) {
+        auto& victim = *workers[(self + i) % workers.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    /* tasks never submit tasks, so once every deque is empty we are done */
+    return false;
+}
+
+void WorkStealingPool::run()
+{
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        threads.emplace_back([this, i]() {
+            std::function<void()> task;
+            while (take(i, task)) {
+                task();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
@@ -0,0 +1,53 @@
+//
+//  WorkStealingPool.hpp
+//  simple_cross
+//
+//  Fixed-size work-stealing thread pool.
+//
+
+#ifndef WorkStealingPool_hpp
+#define WorkStealingPool_hpp
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Fixed-size work-stealing thread pool
+ * @discussion Tasks are distributed round-robin to per-worker deques before `run()` is called.
+ * Each worker pops from the back of its own deque and, once that is empty, steals from the front
+ * of the other workers' deques, so long sessions do not leave the other workers idle.
+ * Tasks must not submit further tasks.
+ */
+class WorkStealingPool {
+    struct Worker {
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    /** @brief Per-worker task deques */
+    std::vector<std::unique_ptr<Worker>> workers;
+    /** @brief Worker that receives the next submitted task */
+    size_t nextWorker = 0;
+
+    /** @brief Take a task from worker `self`, or steal one from another worker */
+    bool take(size_t self, std::function<void()>& task);
+
+public:
+    /** @brief Create a pool with `threads` workers (at least one) */
+    explicit WorkStealingPool(size_t threads);
+
+    /** @brief Queue a task. Must not be called while `run()` is executing. */
+    void submit(std::function<void()> task);
+
+    /** @brief Run all queued tasks to completion on the pool's threads */
+    void run();
+
+    /** @brief Number of workers */
+    size_t size() const { return workers.size(); }
+};
+
+#endif /* WorkStealingPool_hpp */
@@ -20,6 +20,13 @@
  O - place order, requires OID, SYMBOL, SIDE, QTY, PX
  X - cancel order, requires OID
  P - print sorted book (see example below)
+ A - run a call auction, uncrossing the book of every symbol
+ M - set matching mode, requires MODE
+
+ MODE: single character value with the following definitions
+ C - continuous: orders are matched as they are entered (default)
+ A - auction: orders rest in the book without crossing until the next
+ call auction. Switching back to continuous runs a call auction first.
 
  OID: positive 32-bit integer value which must be unique for all orders
 
@@ -130,18 +137,25 @@
 // Stub implementation and example driver for SimpleCross.
 // Your crossing logic should be accesible from the SimpleCross class.
 // Other than the signature of SimpleCross::action() you are free to modify as needed.
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <list>
 #include <map>
-#include <set>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unistd.h>
 #include <variant>
+#include <vector>
 
+#include "FlightRecorder.hpp"
 #include "Order.hpp"
 #include "Price.hpp"
+#include "Profiler.hpp"
+#include "Replay.hpp"
+#include "WorkStealingPool.hpp"
 #include "simple_cross.hpp"
 
 /**
@@ -236,11 +250,376 @@ static bool reachedEnd(std::stringstream& sstream)
     return true;
 }
 
+/** @brief Price in 0.00001 ticks, for trace records */
+template <typename P>
+static uint64_t traceTicks(const P& price)
+{
+    return TickPrice(price).ticks;
+}
+
+/** @brief Side character, for trace records */
+static char sideChar(OrderSide side)
+{
+    return side == OrderSide::Buy ? 'B' : 'S';
+}
+
+/**
+ * @brief Match an incoming order against the opposite side of the book
+ * @discussion Levels are visited in priority order and orders within a level in FIFO order.
+ *  An incoming order crosses a level unless its price is strictly behind the level's price
+ *  according to the opposite side's ordering.
+ * @param order Incoming order; its quantity is reduced by the filled amount
+ * @param levels Opposite side of the book
+ * @param fills Fills are appended here, incoming order first for each execution
+ */
+template <typename Levels>
+static void match(Order& order, Levels& levels, std::vector<Fill<typename Levels::key_type>>& fills)
+{
+    const typename Levels::key_type price(order.price);
+
+    /* while we still have shares in the current order and levels to match against */
+    while (order.quantity > 0 && !levels.empty()) {
+        auto levelIt = levels.begin();
+        auto&& [levelPrice, level] = *levelIt;
+
+        /* check if trade can be executed */
+        if (levels.key_comp()(price, levelPrice)) {
+            break;
+        }
+
+        const uint64_t levelTicks = traceTicks(levelPrice);
+        FlightRecorder::record(TraceEvent::LevelTouched, 0, order.oid, (uint32_t)level.live, order.quantity, levelTicks);
+        while (order.quantity > 0 && level.live > 0) {
+            auto& match = level.front();
+            FlightRecorder::record(TraceEvent::MatchAttempted, 0, order.oid, match.oid, match.quantity, levelTicks);
+
+            uint16_t filledQty = std::min(order.quantity, match.quantity);
+            /* record fill */
+            fills.push_back({ order.oid, filledQty, levelPrice });
+            fills.push_back({ match.oid, filledQty, levelPrice });
+            FlightRecorder::record(TraceEvent::Fill, 0, order.oid, match.oid, filledQty, levelTicks);
+
+            /* subtract filled quantity */
+            order.quantity -= filledQty;
+            match.quantity -= filledQty;
+
+            /* check if match still has shares */
+            if (match.quantity == 0) {
+                /* if not, retire the match */
+                level.retireFront();
+            }
+        }
+
+        if (level.live == 0) {
+            levels.erase(levelIt);
+        } else {
+            level.compact();
+        }
+    }
+
+    TraceStopReason reason = order.quantity == 0 ? TraceStopReason::Filled : levels.empty() ? TraceStopReason::BookEmpty
+                                                                                              : TraceStopReason::PriceNotCrossed;
+    FlightRecorder::record(TraceEvent::MatchStopped, 0, order.oid, (uint32_t)reason, order.quantity, 0);
+}
+
+/**
+ * @brief Add the unfilled remainder of an order to its side of the book
+ */
+template <typename Levels>
+static void rest(Order& order, Levels& levels)
+{
+    order.book_seq = levels[typename Levels::key_type(order.price)].push(&order, order.quantity);
+    FlightRecorder::record(TraceEvent::Insert, sideChar(order.side), order.oid, 0, order.quantity, traceTicks(order.price));
+}
+
+/**
+ * @brief Whether an order at `price` may rest on `levels`
+ * @discussion Book sides with a bounded price range expose `canInsert()`; all others accept any price.
+ */
+template <typename Levels>
+static bool canRest(const Levels& levels, const Price& price)
+{
+    if constexpr (requires { levels.canInsert(typename Levels::key_type(price)); }) {
+        return levels.canInsert(typename Levels::key_type(price));
+    } else {
+        return true;
+    }
+}
+
+/**
+ * @brief Remove a resting order from its side of the book
+ */
+template <typename Levels>
+static void cancel(Order& order, Levels& levels)
+{
+    auto levelIt = levels.find(typename Levels::key_type(order.price));
+    auto& level = levelIt->second;
+    auto& resting = level.at(*order.book_seq);
+    FlightRecorder::record(TraceEvent::Cancel, sideChar(order.side), order.oid, 0, resting.quantity, traceTicks(order.price));
+    resting.quantity = 0;
+    level.live--;
+    if (level.live == 0) {
+        levels.erase(levelIt);
+    }
+    order.book_seq = std::nullopt;
+}
+
+/**
+ * @brief Uncross one symbol's book in a single call auction
+ * @discussion The clearing price is the level price that maximizes executed volume. Ties are broken
+ *  by the smallest imbalance between demand and supply, then by the lowest price. Every execution
+ *  happens at the clearing price, with both sides allocated in price-time priority.
+ * @param book Book to uncross
+ * @param fills Fills are appended here, buy side first for each execution
+ */
+template <typename Book, typename PriceT>
+static void uncross(Book& book, std::vector<Fill<PriceT>>& fills)
+{
+    if (book.buys.empty() || book.sells.empty() || book.buys.begin()->first < book.sells.begin()->first) {
+        /* book is not crossed */
+        return;
+    }
+
+    /* aggregate open quantity per price, lowest price first */
+    struct Depth {
+        PriceT price;
+        uint64_t buy;
+        uint64_t sell;
+    };
+    std::vector<Depth> depth;
+    auto buyIt = book.buys.rbegin();
+    auto sellIt = book.sells.begin();
+    while (buyIt != book.buys.rend() || sellIt != book.sells.end()) {
+        if (sellIt == book.sells.end() || (buyIt != book.buys.rend() && buyIt->first < sellIt->first)) {
+            depth.push_back(Depth { buyIt->first, buyIt->second.openQuantity(), 0 });
+            ++buyIt;
+        } else if (buyIt == book.buys.rend() || sellIt->first < buyIt->first) {
+            depth.push_back(Depth { sellIt->first, 0, sellIt->second.openQuantity() });
+            ++sellIt;
+        } else {
+            depth.push_back(Depth { sellIt->first, buyIt->second.openQuantity(), sellIt->second.openQuantity() });
+            ++buyIt;
+            ++sellIt;
+        }
+    }
+
+    /* demand at a price is all buys at or above it, supply is all sells at or below it */
+    uint64_t demand = 0;
+    for (const auto& level : depth) {
+        demand += level.buy;
+    }
+    uint64_t supply = 0;
+    uint64_t volume = 0;
+    uint64_t imbalance = 0;
+    PriceT clearing = depth.front().price;
+    for (const auto& level : depth) {
+        supply += level.sell;
+        uint64_t executable = std::min(demand, supply);
+        uint64_t surplus = demand > supply ? demand - supply : supply - demand;
+        if (executable > volume || (executable == volume && surplus < imbalance)) {
+            volume = executable;
+            imbalance = surplus;
+            clearing = level.price;
+        }
+        demand -= level.buy;
+    }
+
+    /* execute everything at the clearing price in one pass over both sides */
+    const uint64_t clearingTicks = traceTicks(clearing);
+    FlightRecorder::record(TraceEvent::Auction, 0, 0, (uint32_t)std::min<uint64_t>(volume, UINT32_MAX), 0, clearingTicks);
+    while (volume > 0) {
+        auto& buyLevel = book.buys.begin()->second;
+        auto& sellLevel = book.sells.begin()->second;
+        auto& buy = buyLevel.front();
+        auto& sell = sellLevel.front();
+
+        uint16_t filledQty = std::min(buy.quantity, sell.quantity);
+        fills.push_back({ buy.oid, filledQty, clearing });
+        fills.push_back({ sell.oid, filledQty, clearing });
+        FlightRecorder::record(TraceEvent::Fill, 0, buy.oid, sell.oid, filledQty, clearingTicks);
+        buy.quantity -= filledQty;
+        sell.quantity -= filledQty;
+        volume -= filledQty;
+
+        if (buy.quantity == 0) {
+            buyLevel.retireFront();
+            if (buyLevel.live == 0) {
+                book.buys.erase(book.buys.begin());
+            }
+        }
+        if (sell.quantity == 0) {
+            sellLevel.retireFront();
+            if (sellLevel.live == 0) {
+                book.sells.erase(book.sells.begin());
+            }
+        }
+    }
+
+    if (!book.buys.empty()) {
+        book.buys.begin()->second.compact();
+    }
+    if (!book.sells.empty()) {
+        book.sells.begin()->second.compact();
+    }
+}
+
+/**
+ * @brief Render every resting order of a book as `P` lines, sells from the highest price down, then buys
+ * @param emit Called with each line, without a trailing newline
+ */
+template <typename Book, typename Emit>
+static void renderBook(const std::string& symbol, const Book& book, Emit&& emit)
+{
+    using std::to_string;
+
+    std::string entry;
+    auto render = [&](const RestingOrder& resting, const char* side, const std::string& priceStr) {
+        entry.assign("P ").append(to_string(resting.oid)).append(" ").append(symbol).append(side);
+        entry.append(to_string(resting.quantity)).append(" ").append(priceStr);
+        emit(entry);
+    };
+
+    /* sells in reverse order */
+    for (auto levelIt = book.sells.rbegin(); levelIt != book.sells.rend(); ++levelIt) {
+        const auto& [price, level] = *levelIt;
+        const std::string priceStr = to_string(price);
+        for (auto orderIt = level.orders.rbegin(); orderIt != level.orders.rend(); ++orderIt) {
+            if (orderIt->quantity > 0) {
+                render(*orderIt, " S ", priceStr);
+            }
+        }
+    }
+    for (const auto& [price, level] : book.buys) {
+        const std::string priceStr = to_string(price);
+        for (const auto& resting : level.orders) {
+            if (resting.quantity > 0) {
+                render(resting, " B ", priceStr);
+            }
+        }
+    }
+}
+
+/** @brief Number of open orders in a book */
+template <typename Book>
+static size_t openOrders(const Book& book)
+{
+    size_t count = 0;
+    for (const auto& [price, level] : book.sells) {
+        count += level.live;
+    }
+    for (const auto& [price, level] : book.buys) {
+        count += level.live;
+    }
+    return count;
+}
+
+/** @brief Approximate number of open orders rendered per batch of a streamed `P` dump; bounds its peak memory */
+constexpr size_t RENDER_BATCH_ORDERS = size_t(1) << 18;
+/** @brief Batches with fewer open orders than this are rendered on the calling thread */
+constexpr size_t RENDER_PARALLEL_MIN_ORDERS = size_t(1) << 14;
+
+template <typename OrderIndex, template <typename, typename> class BookSide, typename PriceT>
+BasicSimpleCross<OrderIndex, BookSide, PriceT>::BasicSimpleCross(MatchingMode _mode)
+    : mode(_mode)
+    , renderThreads(std::max(1u, std::thread::hardware_concurrency()))
+{
+}
+
+template <typename OrderIndex, template <typename, typename> class BookSide, typename PriceT>
+size_t BasicSimpleCross<OrderIndex, BookSide, PriceT>::action(const std::string& line, std::ostream& out)
+{
+    results_t results = perform(line, &out);
+    for (const auto& result : results) {
+        out << result << '\n';
+    }
+    return results.size() + std::exchange(streamedLines, 0);
+}
+
+template <typename OrderIndex, template <typename, typename> class BookSide, typename PriceT>
+size_t BasicSimpleCross<OrderIndex, BookSide, PriceT>::streamBook(std::ostream& out)
+{
+    std::vector<const typename decltype(books)::value_type*> batch;
+    size_t batchOrders = 0;
+    size_t lines = 0;
+
+    /* render the batch into per-symbol buffers, then write them in symbol order */
+    auto flush = [&]() {
+        std::vector<std::string> buffers(batch.size());
+        auto renderSymbol = [&](size_t i) {
+            renderBook(batch[i]->first, batch[i]->second, [&](const std::string& entry) {
+                buffers[i].append(entry).push_back('\n');
+            });
+        };
+        if (renderThreads > 1 && batch.size() > 1 && batchOrders >= RENDER_PARALLEL_MIN_ORDERS) {
+            WorkStealingPool pool(std::min(renderThreads, batch.size()));
+            for (size_t i = 0; i < batch.size(); ++i) {
+                pool.submit([&, i]() { renderSymbol(i); });
+            }
+            pool.run();
+        } else {
+            for (size_t i = 0; i < batch.size(); ++i) {
+                renderSymbol(i);
+            }
+        }
+        for (const auto& buffer : buffers) {
+            out.write(buffer.data(), buffer.size());
+        }
+        lines += batchOrders;
+        batch.clear();
+        batchOrders = 0;
+    };
+
+    for (const auto& entry : books) {
+        size_t count = openOrders(entry.second);
+        if (count == 0) {
+            continue;
+        }
+        batch.push_back(&entry);
+        batchOrders += count;
+        if (batchOrders >= RENDER_BATCH_ORDERS) {
+            flush();
+        }
+    }
+    flush();
+    return lines;
+}
+
+template <typename OrderIndex, template <typename, typename> class BookSide, typename PriceT>
+void BasicSimpleCross<OrderIndex, BookSide, PriceT>::auction(results_t& outputs)
+{
+    for (auto& [symbol, book] : books) {
+        enterPhase(ProfilePhase::Match);
+        uncross(book, fills);
+        enterPhase(ProfilePhase::Format);
+        formatFills(symbol, outputs);
+    }
+}
+
+template <typename OrderIndex, template <typename, typename> class BookSide, typename PriceT>
+void BasicSimpleCross<OrderIndex, BookSide, PriceT>::formatFills(const std::string& symbol, results_t& outputs)
+{
+    using std::to_string;
+
+    /* fills come in runs at the same price, so only format a price when it changes */
+    std::string priceStr;
+    for (size_t i = 0; i < fills.size(); ++i) {
+        if (i == 0 || fills[i].price != fills[i - 1].price) {
+            priceStr = to_string(fills[i].price);
+        }
+        outputs.push_back("F " + to_string(fills[i].oid) + " " + symbol + " " + to_string(fills[i].quantity) + " " + priceStr);
+    }
+    fills.clear();
+}
+
 constexpr size_t MAX_SYMBOL_SIZE = 8;
-results_t SimpleCross::action(const std::string& line)
+template <typename OrderIndex, template <typename, typename> class BookSide, typename PriceT>
+results_t BasicSimpleCross<OrderIndex, BookSide, PriceT>::perform(const std::string& line, std::ostream* stream)
 {
     using std::to_string;
 
+    char action = 0;
+    ProfileScope profile(profiler, action);
+
     std::list<std::string> outputs;
     std::stringstream ss(line);
     if (line.size() == 0) {
@@ -248,7 +627,6 @@ results_t SimpleCross::action(const std::string& line)
         outputs.push_back("");
         return outputs;
     }
-    char action;
     switch (parse(ss, action)) {
     case InputParseResult::Success:
         break;
@@ -360,66 +738,49 @@ results_t SimpleCross::action(const std::string& line)
             return outputs;
         }
 
+        FlightRecorder::record(TraceEvent::ActionDecoded, action, oid, (uint32_t)sideCh, quantity, traceTicks(price));
+        enterPhase(ProfilePhase::Match);
+
+        /* get the OrderBook for this symbol */
+        auto& bookForSymbol = books[symbol];
+
+        /* check that the order could rest on its side of the book */
+        if (!(side == OrderSide::Buy ? canRest(bookForSymbol.buys, price) : canRest(bookForSymbol.sells, price))) {
+            outputs.push_back("E Price outside of supported range");
+            return outputs;
+        }
+
         /* create the order and insert it into `activeOrders` */
-        auto [orderIt, inserted] = activeOrders.emplace(std::make_pair(oid, Order(oid, symbol, side, quantity, price)));
+        auto [orderPtr, inserted] = activeOrders.emplace(Order(oid, symbol, side, quantity, price));
         if (!inserted) {
             /* order with the same ID already exists */
             outputs.push_back("E " + to_string(oid) + " Duplicate order id");
             return outputs;
         }
         /* get the order we just inserted */
-        auto& [_, order] = *orderIt;
+        auto& order = *orderPtr;
 
-        /* get the OrderBook for this symbol */
-        auto& bookForSymbol = books[order.symbol];
-        /* get the opposite side of the orders */
-        auto& oppositeOrders = order.side == OrderSide::Buy ? bookForSymbol.sells : bookForSymbol.buys;
-
-        /* while we still have shares in the current order and orders to match against */
-        while (order.quantity > 0 && !oppositeOrders.empty()) {
-            /* get the first match */
-            auto match = oppositeOrders.begin();
-
-            /* check if trade can be executed */
-            if ((order.side == OrderSide::Buy && order.price >= (*match)->price) || (order.side == OrderSide::Sell && order.price <= (*match)->price)) {
-
-                uint16_t filledQty = std::min(order.quantity, (*match)->quantity);
-                /* report fill */
-                outputs.push_back("F " + to_string(order.oid) + " " + order.symbol + " " + to_string(filledQty) + " " + to_string((*match)->price));
-                outputs.push_back("F " + to_string((*match)->oid) + " " + (*match)->symbol + " " + to_string(filledQty) + " " + to_string((*match)->price));
-
-                /* subtract filled quantity */
-                order.quantity -= filledQty;
-
-                /* check if match still has shares */
-                if ((*match)->quantity == filledQty) {
-                    /* if not, delete the match */
-                    auto book_iter = *(*match)->book_iter;
-
-                    (*match)->quantity = 0;
-                    (*match)->book_iter = std::nullopt;
-                    oppositeOrders.erase(book_iter);
-                } else {
-                    /* subtract the filled quantity */
-                    (*match)->quantity -= filledQty;
-                }
-            } else {
-                break;
+        /* match against the opposite side (unless waiting for a call auction),
+         * then add any remaining shares to the order book */
+        if (order.side == OrderSide::Buy) {
+            if (mode == MatchingMode::Continuous) {
+                match(order, bookForSymbol.sells, fills);
             }
-        }
-
-        /* check if there are any shares left in the order that were not filled */
-        if (order.quantity > 0) {
-            /* add remaining to order book */
-            if (order.side == OrderSide::Buy) {
-                const auto [book_iter, __] = bookForSymbol.buys.insert(&order);
-                order.book_iter = book_iter;
-            } else {
-                const auto [book_iter, __] = bookForSymbol.sells.insert(&order);
-                order.book_iter = book_iter;
+            if (order.quantity > 0) {
+                rest(order, bookForSymbol.buys);
+            }
+        } else {
+            if (mode == MatchingMode::Continuous) {
+                match(order, bookForSymbol.buys, fills);
+            }
+            if (order.quantity > 0) {
+                rest(order, bookForSymbol.sells);
             }
         }
 
+        enterPhase(ProfilePhase::Format);
+        formatFills(order.symbol, outputs);
+
     } else if (action == 'X') {
         OID oid;
         switch (parse(ss, oid)) {
@@ -443,22 +804,24 @@ results_t SimpleCross::action(const std::string& line)
             return outputs;
         }
 
-        auto found = activeOrders.find(oid);
-        if (found != activeOrders.end()) {
-            auto& order = found->second;
+        FlightRecorder::record(TraceEvent::ActionDecoded, action, oid, 0, 0, 0);
+        enterPhase(ProfilePhase::Match);
+        Order* found = activeOrders.find(oid);
+        if (found != nullptr) {
+            auto& order = *found;
             if (order.quantity == 0) {
                 /* already filled */
                 outputs.push_back("E Already filled order " + to_string(oid));
                 return outputs;
             }
-            if (order.book_iter != std::nullopt) {
+            if (order.book_seq != std::nullopt) {
                 auto& bookForSymbol = books[order.symbol];
                 if (order.side == OrderSide::Buy) {
-                    bookForSymbol.buys.erase(*order.book_iter);
+                    cancel(order, bookForSymbol.buys);
                 } else if (order.side == OrderSide::Sell) {
-                    bookForSymbol.sells.erase(*order.book_iter);
+                    cancel(order, bookForSymbol.sells);
                 }
-                order.book_iter = std::nullopt;
+                enterPhase(ProfilePhase::Format);
                 outputs.push_back("X " + to_string(oid));
             } else {
                 /* already canceled */
@@ -472,16 +835,51 @@ results_t SimpleCross::action(const std::string& line)
             outputs.push_back("E Expected end of input");
             return outputs;
         }
-        for (const auto& [symbol, book] : books) {
-            /* sells in reverse order */
-            for (auto sellsIt = book.sells.rbegin(); sellsIt != book.sells.rend(); ++sellsIt) {
-                const auto& order = **sellsIt;
-                outputs.push_back("P " + to_string(order.oid) + " " + order.symbol + " S " + to_string(order.quantity) + " " + to_string(order.price));
+        FlightRecorder::record(TraceEvent::ActionDecoded, action, 0, 0, 0, 0);
+        enterPhase(ProfilePhase::Format);
+        if (stream) {
+            streamedLines = streamBook(*stream);
+        } else {
+            for (const auto& [symbol, book] : books) {
+                renderBook(symbol, book, [&](const std::string& entry) { outputs.push_back(entry); });
             }
-            for (const auto& orderPtr : book.buys) {
-                const auto& order = *orderPtr;
-                outputs.push_back("P " + to_string(order.oid) + " " + order.symbol + " B " + to_string(order.quantity) + " " + to_string(order.price));
+        }
+    } else if (action == 'A') {
+        if (!reachedEnd(ss)) {
+            outputs.push_back("E Expected end of input");
+            return outputs;
+        }
+        FlightRecorder::record(TraceEvent::ActionDecoded, action, 0, 0, 0, 0);
+        auction(outputs);
+    } else if (action == 'M') {
+        char modeCh;
+        switch (parse(ss, modeCh)) {
+        case InputParseResult::Success:
+            if (modeCh != 'C' && modeCh != 'A') {
+                outputs.push_back("E Mode must be either 'C' or 'A'");
+                return outputs;
             }
+            break;
+        case InputParseResult::BadInput:
+            outputs.push_back("E Mode is malformed");
+            return outputs;
+        case InputParseResult::EndOfFile:
+            outputs.push_back("E Expected mode in input");
+            return outputs;
+        }
+
+        if (!reachedEnd(ss)) {
+            outputs.push_back("E Expected end of input");
+            return outputs;
+        }
+
+        FlightRecorder::record(TraceEvent::ActionDecoded, action, 0, (uint32_t)modeCh, 0, 0);
+        if (modeCh == 'C') {
+            /* continuous matching requires an uncrossed book */
+            auction(outputs);
+            mode = MatchingMode::Continuous;
+        } else {
+            mode = MatchingMode::Auction;
         }
     } else {
         outputs.push_back("E Unknown action " + std::string(1, action));
@@ -489,32 +887,49 @@ results_t SimpleCross::action(const std::string& line)
     return outputs;
 }
 
-static int readActions(std::istream& actions)
+template class BasicSimpleCross<MapOrderIndex, MapBookSide, Price>;
+template class BasicSimpleCross<DenseOrderIndex, LadderBookSide, TickPrice>;
+
+#ifndef SIMPLE_CROSS_NO_MAIN
+static int readActions(std::istream& actions, bool profile)
 {
-    SimpleCross scross;
-    std::string line;
-    while (std::getline(actions, line)) {
-        results_t results = scross.action(line);
-        for (results_t::const_iterator it = results.begin(); it != results.end(); ++it) {
-            std::cout << *it << std::endl;
-        }
+    if (!profile) {
+        replaySession(actions, std::cout);
+        return 0;
     }
+    ActionProfiler profiler;
+    replaySession(actions, std::cout, &profiler);
+    std::cout.flush();
+    profiler.report(std::cerr);
     return 0;
 }
 
-int main(int argc, char** argv)
+/**
+ * @brief Run the driver on its non-option arguments
+ * @param program Program name, for usage messages
+ * @param args Arguments following the options
+ * @param profile Whether to profile the session
+ */
+static int run(const char* program, const std::vector<std::string>& args, bool profile)
 {
-    if (argc == 2) {
-        if (strncmp(argv[1], "-", strlen("-")) == 0) {
+    if (args.size() >= 1 && args[0] == "--replay") {
+        /* replay many sessions in parallel */
+        if (args.size() < 3) {
+            std::cerr << "Usage: " << program << " --replay OUTPUT_DIR INPUT..." << std::endl;
+            return 1;
+        }
+        return replay(args[1], std::vector<std::string>(args.begin() + 2, args.end()));
+    } else if (args.size() == 1) {
+        if (strncmp(args[0].c_str(), "-", strlen("-")) == 0) {
             /* read from stdin */
-            return readActions(std::cin);
+            return readActions(std::cin, profile);
         } else {
-            auto actions = std::ifstream(argv[1], std::ios::in);
+            auto actions = std::ifstream(args[0], std::ios::in);
             if (actions.fail()) {
-                std::cerr << "Failed to read " << argv[1] << std::endl;
+                std::cerr << "Failed to read " << args[0] << std::endl;
                 return 1;
             }
-            return readActions(actions);
+            return readActions(actions, profile);
         }
     } else {
         /* look for actions.txt in the current directory */
@@ -523,6 +938,38 @@ int main(int argc, char** argv)
             std::cerr << "Failed to read actions.txt" << std::endl;
             return 1;
         }
-        return readActions(actions);
+        return readActions(actions, profile);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool profile = false;
+    const char* tracePath = nullptr;
+    int first = 1;
+    while (first < argc) {
+        if (strcmp(argv[first], "--profile") == 0) {
+            /* profile the session and print a summary to stderr */
+            profile = true;
+            first++;
+        } else if (strcmp(argv[first], "--trace") == 0 && first + 1 < argc) {
+            /* dump the flight recorder to this file on exit as well as on crash */
+            tracePath = argv[first + 1];
+            first += 2;
+        } else {
+            break;
+        }
+    }
+
+    /* the flight recorder is always on; dump it if we crash or on SIGUSR1 */
+    std::string crashTracePath = tracePath ? tracePath : "simple_cross." + std::to_string(getpid()) + ".trace";
+    FlightRecorder::installSignalHandlers(crashTracePath.c_str());
+
+    int status = run(argv[0], std::vector<std::string>(argv + first, argv + argc), profile);
+    if (tracePath && !FlightRecorder::dump(tracePath)) {
+        std::cerr << "Failed to write " << tracePath << std::endl;
+        return 1;
     }
+    return status;
 }
+#endif /* SIMPLE_CROSS_NO_MAIN */
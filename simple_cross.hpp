@@ -8,43 +8,151 @@
 #ifndef simple_cross_h
 #define simple_cross_h
 
+#include <functional>
+#include <iostream>
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
 
+#include "BookSide.hpp"
 #include "Order.hpp"
+#include "OrderIndex.hpp"
+#include "Price.hpp"
+#include "Profiler.hpp"
 
 /* String output type */
 typedef std::list<std::string> results_t;
 
 /**
  * @brief Order book structure
- * @discussion Contains separate structures for buy and sell orders. The orders are referenced by
- * pointer; the actual Order structure is stored in SimpleCross's activeOrders.
+ * @discussion Contains separate book sides for buy and sell orders, keyed by price in priority order.
+ * The cold order metadata is stored in the engine's activeOrders.
  */
-struct OrderBook {
-    struct OrderPtrComparator {
-        inline bool operator()(const Order* lhs, const Order* rhs) const
-        {
-            return (*lhs) < (*rhs);
-        }
-    };
+template <template <typename, typename> class BookSide, typename PriceT>
+struct BasicOrderBook {
+    /** @brief Buy orders, highest price first */
+    BookSide<PriceT, std::greater<PriceT>> buys;
+    /** @brief Sell orders, lowest price first */
+    BookSide<PriceT, std::less<PriceT>> sells;
+};
+
+/**
+ * @brief A fill of one order, recorded while matching and formatted into an `F` result afterwards
+ */
+template <typename PriceT>
+struct Fill {
+    /** @brief Filled order */
+    OID oid;
+    /** @brief Filled quantity */
+    uint16_t quantity;
+    /** @brief Fill price */
+    PriceT price;
+};
 
-    /** @brief Buy orders */
-    std::set<Order*, OrderPtrComparator> buys;
-    /** @brief Sell orders */
-    std::set<Order*, OrderPtrComparator> sells;
+/**
+ * @brief Matching modes
+ * @discussion In continuous mode incoming orders are matched immediately. In auction mode orders
+ * accumulate in the book without crossing until a call auction uncrosses it.
+ */
+enum class MatchingMode {
+    Continuous,
+    Auction
 };
 
-class SimpleCross {
+/**
+ * @brief Matching engine
+ * @discussion Parameterized by policies so that specialized variants can be selected at compile time:
+ * - `OrderIndex`: maps OIDs to orders (see OrderIndex.hpp)
+ * - `BookSide`: price-to-level structure for each side of a book (see BookSide.hpp)
+ * - `PriceT`: price representation used as the book side key; constructible from `Price`
+ * Member functions are defined in simple_cross.cpp and explicitly instantiated there for each variant below.
+ */
+template <typename OrderIndex = MapOrderIndex, template <typename, typename> class BookSide = MapBookSide, typename PriceT = Price>
+class BasicSimpleCross {
+    using OrderBook = BasicOrderBook<BookSide, PriceT>;
+
+    /** @brief Current matching mode */
+    MatchingMode mode;
+
     /** @brief Mapping from order ID to order */
-    std::map<OID, Order> activeOrders;
+    OrderIndex activeOrders;
 
     /** @brief Mapping from symbol to `OrderBook` */
     std::map<std::string, OrderBook> books;
 
+    /** @brief Fills of the action in progress, reused across actions */
+    std::vector<Fill<PriceT>> fills;
+
+    /** @brief Attached profiler, if profiling */
+    ActionProfiler* profiler = nullptr;
+
+    /** @brief Number of threads used to render streamed `P` dumps */
+    size_t renderThreads;
+
+    /** @brief Lines streamed by the action in progress */
+    size_t streamedLines = 0;
+
+    /** @brief Run a call auction on every symbol's book, appending fills to `outputs` */
+    void auction(results_t& outputs);
+
+    /** @brief Format `fills` for `symbol` into `outputs` and clear them */
+    void formatFills(const std::string& symbol, results_t& outputs);
+
+    /**
+     * @brief Perform an action
+     * @param stream If set, a `P` dump is streamed here instead of being returned
+     */
+    results_t perform(const std::string& line, std::ostream* stream);
+
+    /**
+     * @brief Stream the full book to `out`
+     * @discussion Symbols are rendered in parallel into per-symbol buffers, in batches of about
+     *  `RENDER_BATCH_ORDERS` open orders, and each batch is written in symbol order before the next is rendered.
+     * @return Number of lines written
+     */
+    size_t streamBook(std::ostream& out);
+
+    /** @brief Mark the start of a profiling phase */
+    void enterPhase(ProfilePhase phase)
+    {
+        if (profiler) {
+            profiler->enter(phase);
+        }
+    }
+
 public:
-    results_t action(const std::string& line);
+    BasicSimpleCross(MatchingMode mode = MatchingMode::Continuous);
+
+    /** @brief Attribute the cost of subsequent actions to `profiler` (nullptr to stop profiling) */
+    void setProfiler(ActionProfiler* _profiler) { profiler = _profiler; }
+
+    /** @brief Use `threads` threads to render streamed `P` dumps (defaults to the number of cores) */
+    void setRenderThreads(size_t threads) { renderThreads = threads; }
+
+    results_t action(const std::string& line) { return perform(line, nullptr); }
+
+    /**
+     * @brief Perform an action and write its results to `out`, one per line
+     * @discussion Equivalent to writing the results of `action(line)`, except that a `P` dump is rendered
+     *  in parallel and streamed in chunks rather than materialized as one list.
+     * @return Number of lines written
+     */
+    size_t action(const std::string& line, std::ostream& out);
 };
 
+/** @brief General purpose engine: ordered maps for OIDs and price levels */
+using DefaultEngine = BasicSimpleCross<MapOrderIndex, MapBookSide, Price>;
+/** @brief Engine for dense OIDs and narrow-tick instruments: paged OID array and per-tick price ladders */
+using DenseTickEngine = BasicSimpleCross<DenseOrderIndex, LadderBookSide, TickPrice>;
+
+extern template class BasicSimpleCross<MapOrderIndex, MapBookSide, Price>;
+extern template class BasicSimpleCross<DenseOrderIndex, LadderBookSide, TickPrice>;
+
+/* Engine variant used by the driver; select another with -DSIMPLE_CROSS_ENGINE=... */
+#ifndef SIMPLE_CROSS_ENGINE
+#define SIMPLE_CROSS_ENGINE DefaultEngine
+#endif
+using SimpleCross = SIMPLE_CROSS_ENGINE;
+
 #endif /* simple_cross_h */
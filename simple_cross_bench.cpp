@@ -0,0 +1,179 @@
+//
+//  simple_cross_bench.cpp
+//  simple_cross
+//
+//  Micro-benchmark for `SimpleCross::action()` on deep books.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "FlightRecorder.hpp"
+#include "simple_cross.hpp"
+
+/** @brief Number of price levels per side in the deep book */
+constexpr uint32_t LEVELS = 500;
+/** @brief Number of resting orders per price level */
+constexpr uint32_t ORDERS_PER_LEVEL = 120;
+/** @brief Number of build/cancel/sweep rounds */
+constexpr uint32_t ROUNDS = 10;
+
+/**
+ * @brief Format a price in 7.5 format
+ * @param ticks Price in units of 0.00001
+ */
+static std::string formatTicks(uint64_t ticks)
+{
+    std::string frac = std::to_string(ticks % 100000);
+    return std::to_string(ticks / 100000) + "." + std::string(5 - frac.size(), '0') + frac;
+}
+
+/**
+ * @brief Timer for one benchmark phase
+ */
+struct Phase {
+    const char* name;
+    std::chrono::nanoseconds elapsed { 0 };
+    uint64_t actions = 0;
+
+    void report() const
+    {
+        std::cout << std::left << std::setw(8) << name
+                  << std::right << std::setw(12) << actions << " actions "
+                  << std::setw(10) << std::fixed << std::setprecision(1)
+                  << (double)elapsed.count() / (double)actions << " ns/action" << std::endl;
+    }
+};
+
+template <typename F>
+static void timed(Phase& phase, const std::vector<std::string>& lines, F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& line : lines) {
+        f(line);
+    }
+    phase.elapsed += std::chrono::steady_clock::now() - start;
+    phase.actions += lines.size();
+}
+
+/**
+ * @brief Run the deep book benchmark against one engine variant
+ * @param name Name of the variant to report
+ */
+template <typename Engine>
+static void runBench(const char* name)
+{
+    Phase insert { "insert" };
+    Phase cancel { "cancel" };
+    Phase sweep { "sweep" };
+    std::mt19937 rng(42);
+    uint64_t fills = 0;
+    OID oid = 1;
+
+    for (uint32_t round = 0; round < ROUNDS; ++round) {
+        Engine scross;
+        std::vector<std::string> inserts;
+        std::vector<std::string> cancels;
+        std::vector<std::string> sweeps;
+
+        /* build a deep sell side: LEVELS levels of ORDERS_PER_LEVEL orders each, interleaved across levels */
+        std::vector<OID> sellOids;
+        for (uint32_t i = 0; i < ORDERS_PER_LEVEL; ++i) {
+            for (uint32_t level = 0; level < LEVELS; ++level) {
+                sellOids.push_back(oid);
+                inserts.push_back("O " + std::to_string(oid++) + " IBM S 1 " + formatTicks(10000000 + level * 1000));
+            }
+        }
+        /* cancel a random quarter of the book */
+        std::shuffle(sellOids.begin(), sellOids.end(), rng);
+        for (size_t i = 0; i < sellOids.size() / 4; ++i) {
+            cancels.push_back("X " + std::to_string(sellOids[i]));
+        }
+        /* sweep the remaining book with marketable buys */
+        size_t remaining = sellOids.size() - cancels.size();
+        while (remaining > 0) {
+            uint16_t qty = (uint16_t)std::min<size_t>(remaining, 20000);
+            sweeps.push_back("O " + std::to_string(oid++) + " IBM B " + std::to_string(qty) + " " + formatTicks(10000000 + LEVELS * 1000));
+            remaining -= qty;
+        }
+
+        timed(insert, inserts, [&](const std::string& line) { scross.action(line); });
+        timed(cancel, cancels, [&](const std::string& line) { scross.action(line); });
+        timed(sweep, sweeps, [&](const std::string& line) { fills += scross.action(line).size(); });
+    }
+
+    std::cout << name << std::endl;
+    insert.report();
+    cancel.report();
+    sweep.report();
+    std::cout << "fills   " << std::setw(12) << fills << " lines, "
+              << std::setprecision(1) << (double)sweep.elapsed.count() / (double)fills << " ns/fill" << std::endl;
+}
+
+/** @brief Number of symbols in the full-book dump benchmark */
+constexpr uint32_t DUMP_SYMBOLS = 2000;
+/** @brief Number of resting orders per symbol in the full-book dump benchmark */
+constexpr uint32_t DUMP_ORDERS_PER_SYMBOL = 500;
+
+/**
+ * @brief Compare rendering the full book as one list against streaming it
+ */
+template <typename Engine>
+static void benchDump(const char* name)
+{
+    Engine scross;
+    OID oid = 1;
+    for (uint32_t symbol = 0; symbol < DUMP_SYMBOLS; ++symbol) {
+        for (uint32_t i = 0; i < DUMP_ORDERS_PER_SYMBOL; ++i) {
+            bool buy = i % 2 == 0;
+            scross.action("O " + std::to_string(oid++) + " S" + std::to_string(symbol) + (buy ? " B 1 " : " S 1 ") + formatTicks(10000000 + (buy ? 0 : 100) + i % 50));
+        }
+    }
+
+    auto devNull = std::ofstream("/dev/null", std::ios::out);
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& line : scross.action("P")) {
+        devNull << line << '\n';
+    }
+    std::chrono::duration<double, std::milli> listed = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    size_t lines = scross.action("P", devNull);
+    std::chrono::duration<double, std::milli> streamed = std::chrono::steady_clock::now() - start;
+
+    std::cout << name << " P dump of " << lines << " orders" << std::endl
+              << "list    " << std::setw(10) << std::fixed << std::setprecision(1) << listed.count() << " ms" << std::endl
+              << "stream  " << std::setw(10) << streamed.count() << " ms" << std::endl;
+}
+
+/**
+ * @brief Measure the cost of one flight recorder event
+ */
+static void benchFlightRecorder()
+{
+    constexpr uint32_t EVENTS = 10000000;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < EVENTS; ++i) {
+        FlightRecorder::record(TraceEvent::Fill, 0, i, i + 1, (uint16_t)i, 10000000);
+    }
+    std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "FlightRecorder" << std::endl
+              << "record  " << std::setw(12) << EVENTS << " events  "
+              << std::setw(10) << std::fixed << std::setprecision(1) << (double)elapsed.count() / EVENTS << " ns/event" << std::endl;
+}
+
+int main()
+{
+    runBench<DefaultEngine>("DefaultEngine");
+    runBench<DenseTickEngine>("DenseTickEngine");
+    benchDump<DefaultEngine>("DefaultEngine");
+    benchDump<DenseTickEngine>("DenseTickEngine");
+    benchFlightRecorder();
+    return 0;
+}
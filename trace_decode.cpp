@@ -0,0 +1,142 @@
+//
+//  trace_decode.cpp
+//  simple_cross
+//
+//  Offline decoder for flight recorder dumps.
+//
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "FlightRecorder.hpp"
+#include "Price.hpp"
+
+/** @brief Name of a trace event */
+static const char* eventName(TraceEvent event)
+{
+    switch (event) {
+    case TraceEvent::ActionDecoded:
+        return "action";
+    case TraceEvent::LevelTouched:
+        return "level";
+    case TraceEvent::MatchAttempted:
+        return "attempt";
+    case TraceEvent::Fill:
+        return "fill";
+    case TraceEvent::MatchStopped:
+        return "stop";
+    case TraceEvent::Insert:
+        return "insert";
+    case TraceEvent::Cancel:
+        return "cancel";
+    case TraceEvent::Auction:
+        return "auction";
+    }
+    return "unknown";
+}
+
+/** @brief Name of a match stop reason */
+static const char* stopReasonName(uint32_t reason)
+{
+    switch ((TraceStopReason)reason) {
+    case TraceStopReason::Filled:
+        return "filled";
+    case TraceStopReason::BookEmpty:
+        return "book-empty";
+    case TraceStopReason::PriceNotCrossed:
+        return "price-not-crossed";
+    }
+    return "unknown";
+}
+
+/** @brief Print one record as a line of text */
+static void printRecord(std::ostream& out, const TraceRecord& record, double nsPerTick, uint64_t startTsc)
+{
+    out << std::setw(14) << std::fixed << std::setprecision(0) << (double)(record.tsc - startTsc) * nsPerTick << " ns "
+        << std::left << std::setw(8) << eventName(record.event) << std::right;
+    switch (record.event) {
+    case TraceEvent::ActionDecoded:
+        out << " " << record.action;
+        if (record.other != 0) {
+            out << " " << (char)record.other;
+        }
+        if (record.oid != 0) {
+            out << " oid=" << record.oid;
+        }
+        if (record.quantity != 0) {
+            out << " qty=" << record.quantity << " px=" << to_string(TickPrice(record.price));
+        }
+        break;
+    case TraceEvent::LevelTouched:
+        out << " oid=" << record.oid << " px=" << to_string(TickPrice(record.price)) << " open=" << record.quantity << " resting=" << record.other;
+        break;
+    case TraceEvent::MatchAttempted:
+        out << " oid=" << record.oid << " resting=" << record.other << " resting_qty=" << record.quantity;
+        break;
+    case TraceEvent::Fill:
+        out << " oid=" << record.oid << " other=" << record.other << " qty=" << record.quantity << " px=" << to_string(TickPrice(record.price));
+        break;
+    case TraceEvent::MatchStopped:
+        out << " oid=" << record.oid << " open=" << record.quantity << " reason=" << stopReasonName(record.other);
+        break;
+    case TraceEvent::Insert:
+    case TraceEvent::Cancel:
+        out << " " << record.action << " oid=" << record.oid << " qty=" << record.quantity << " px=" << to_string(TickPrice(record.price));
+        break;
+    case TraceEvent::Auction:
+        out << " px=" << to_string(TickPrice(record.price)) << " volume=" << record.other;
+        break;
+    }
+    out << '\n';
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " TRACE_FILE" << std::endl;
+        return 1;
+    }
+    auto in = std::ifstream(argv[1], std::ios::in | std::ios::binary);
+    if (in.fail()) {
+        std::cerr << "Failed to read " << argv[1] << std::endl;
+        return 1;
+    }
+
+    TraceFileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0) {
+        std::cerr << "Not a trace file: " << argv[1] << std::endl;
+        return 1;
+    }
+    if (header.recordSize != sizeof(TraceRecord)) {
+        std::cerr << "Unsupported record size " << header.recordSize << std::endl;
+        return 1;
+    }
+    double nsPerTick = header.dumpTsc > header.startTsc ? (double)(header.dumpNs - header.startNs) / (double)(header.dumpTsc - header.startTsc) : 1.0;
+
+    for (uint32_t i = 0; i < header.rings; ++i) {
+        TraceRingHeader ringHeader;
+        if (!in.read(reinterpret_cast<char*>(&ringHeader), sizeof(ringHeader))) {
+            std::cerr << "Truncated trace file" << std::endl;
+            return 1;
+        }
+        std::vector<TraceRecord> records(ringHeader.count);
+        if (!in.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(TraceRecord))) {
+            std::cerr << "Truncated trace file" << std::endl;
+            return 1;
+        }
+
+        uint64_t first = ringHeader.written - ringHeader.count;
+        std::cout << "ring " << ringHeader.ring << ": " << ringHeader.count << " of " << ringHeader.written << " records" << '\n';
+        for (size_t j = 0; j < records.size(); ++j) {
+            if (records[j].seq != (uint32_t)(first + j)) {
+                std::cout << std::setw(17) << "" << "(torn record)" << '\n';
+                continue;
+            }
+            printRecord(std::cout, records[j], nsPerTick, header.startTsc);
+        }
+    }
+    return 0;
+}